@@ -24,6 +24,27 @@ void portfolio_init(Portfolio *p, currency_t initial_capital) {
     }
 }
 
+// Initial Allocation (Simple 60/40 for demo)
+void portfolio_open_default_book(Portfolio *p, Asset *universe) {
+    // Buy NIFTY
+    p->positions[0].asset_index = 0;
+    p->positions[0].units = 2500; // 2500 Units of NIFTY
+    p->positions[0].cost_basis = universe[0].price;
+    p->positions[0].current_val = universe[0].price * 2500;
+    
+    // Buy BONDS
+    p->positions[1].asset_index = 1;
+    p->positions[1].units = 400000; 
+    p->positions[1].cost_basis = universe[1].price;
+    p->positions[1].current_val = universe[1].price * 400000;
+
+    p->position_count = 2;
+    
+    // Adjust cash
+    currency_t invested = p->positions[0].current_val + p->positions[1].current_val;
+    p->cash_balance -= invested;
+}
+
 // --- VALUATION ---
 
 void portfolio_update_valuation(Portfolio *p, Asset *universe) {
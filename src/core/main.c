@@ -7,6 +7,8 @@
 #include <string.h>
 #include <ctype.h>
 #include <time.h> // Added for nanosleep struct
+#include <math.h>
+#include <errno.h>
 
 #include "../phonex.h"
 
@@ -42,8 +44,52 @@ bool kbhit_esc() {
     return false;
 }
 
+// --- MARKET FEED ---
+
+MarketBus feed_bus;
+
+void feed_shutdown() {
+    md_bus_close(&feed_bus); // Unlinks the shm object
+}
+
+// --- REGIME MODEL ---
+
+RegimeModel regime_model;
+
+// --regimes FILE replaces the built-in fixed regimes with a Markov model
+bool load_regimes(int argc, char **argv) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--regimes") == 0) {
+            return regime_model_load(&regime_model, argv[i + 1]);
+        }
+    }
+    regime_model_default(&regime_model);
+    return true;
+}
+
 // --- CONFIG WIZARD ---
 
+// Menu order keeps the original 1-4 choices; 5+ are CUSTOM and file regimes
+static const MarketRegime REGIME_MENU[MAX_REGIMES] = {
+    REGIME_STABLE_GROWTH, REGIME_STAGFLATION, REGIME_GLOBAL_SHOCK, REGIME_LIQUIDITY_CRUNCH,
+    REGIME_CUSTOM, (MarketRegime)5, (MarketRegime)6, (MarketRegime)7
+};
+
+// False if the choice is not a regime of the loaded model.
+bool regime_from_menu(int choice, MarketRegime *out) {
+    if (choice < 1 || choice > regime_model.regime_count) return false;
+    *out = REGIME_MENU[choice - 1];
+    return true;
+}
+
+void print_regime_menu(void) {
+    printf("   > MARKET REGIME (");
+    for (int i = 1; i <= regime_model.regime_count; i++) {
+        printf("%s%d=%s", i > 1 ? ", " : "", i, regime_name(&regime_model, REGIME_MENU[i - 1]));
+    }
+    printf("): ");
+}
+
 void run_wizard(SimConfig *cfg) {
    
     
@@ -57,14 +103,10 @@ void run_wizard(SimConfig *cfg) {
     if (cfg->duration_months > 360) cfg->duration_months = 360;
 
     // 2. REGIME
-    printf("   > MARKET REGIME (1=GROWTH, 2=STAGFLATION, 3=CRASH, 4=LIQUIDITY CRUNCH): ");
+    print_regime_menu();
     int reg_in;
-    if (scanf("%d", &reg_in) != 1) reg_in = 1;
-    switch(reg_in) {
-        case 2: cfg->regime = REGIME_STAGFLATION; break;
-        case 3: cfg->regime = REGIME_LIQUIDITY_CRUNCH; break;
-        case 4: cfg->regime = REGIME_LIQUIDITY_CRUNCH; break; 
-        default: cfg->regime = REGIME_STABLE_GROWTH;
+    if (scanf("%d", &reg_in) != 1 || !regime_from_menu(reg_in, &cfg->regime)) {
+        cfg->regime = REGIME_STABLE_GROWTH;
     }
 
     // 3. RISK
@@ -92,9 +134,147 @@ void run_wizard(SimConfig *cfg) {
     int c; while ((c = getchar()) != '\n' && c != EOF);
 }
 
+// --- BATCH MODE ---
+// phonex_am --batch <paths> [--vr anti,cv,sobol] [--months N] [--regime N]
+//           [--dd PCT] [--margin] [--tail PCT] [--seed N] [--regimes FILE]
+
+// Comma-separated list of anti, cv, sobol (or none). -1 on unknown tokens.
+int parse_vr(const char *val) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s", val);
+
+    int flags = VR_NONE;
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        if (strcmp(tok, "anti") == 0) flags |= VR_ANTITHETIC;
+        else if (strcmp(tok, "cv") == 0) flags |= VR_CONTROL;
+        else if (strcmp(tok, "sobol") == 0) flags |= VR_SOBOL;
+        else if (strcmp(tok, "none") != 0) {
+            fprintf(stderr, "   >> UNKNOWN VARIANCE REDUCTION %s\n", tok);
+            return -1;
+        }
+    }
+    return flags;
+}
+
+// Whole-string numeric parsing; reports and returns false on trailing junk.
+bool parse_long(const char *arg, const char *val, long *out) {
+    char *end;
+    errno = 0;
+    long v = strtol(val, &end, 10);
+    if (end == val || *end != '\0' || errno == ERANGE) {
+        fprintf(stderr, "   >> BAD VALUE FOR %s: %s\n", arg, val);
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+bool parse_double(const char *arg, const char *val, double *out) {
+    char *end;
+    double v = strtod(val, &end);
+    if (end == val || *end != '\0' || !isfinite(v)) {
+        fprintf(stderr, "   >> BAD VALUE FOR %s: %s\n", arg, val);
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+int run_batch(int argc, char **argv) {
+    SimConfig config = {0};
+    config.duration_months = 120;
+    config.regime = REGIME_STABLE_GROWTH;
+    config.max_drawdown_limit = 0.20;
+    config.max_leverage = 1.0;
+
+    McConfig mc = {0};
+    mc.paths = 4096;
+    mc.seed = 123456789;
+    mc.tail_nav_ratio = 0.80;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--margin") == 0) {
+            config.allow_margin = true;
+            config.max_leverage = 1.5;
+            continue;
+        }
+        if (!val) {
+            fprintf(stderr, "   >> MISSING VALUE FOR %s\n", arg);
+            return 2;
+        }
+        i++;
+
+        long n;
+        double x;
+        if (strcmp(arg, "--batch") == 0) {
+            if (!parse_long(arg, val, &n)) return 2;
+            mc.paths = n > MC_MAX_PATHS ? MC_MAX_PATHS : (n < 0 ? 0 : (int)n);
+        } else if (strcmp(arg, "--months") == 0) {
+            if (!parse_long(arg, val, &n)) return 2;
+            config.duration_months = n < 12 ? 12 : (n > 360 ? 360 : (int)n);
+        } else if (strcmp(arg, "--regime") == 0) {
+            if (!parse_long(arg, val, &n)) return 2;
+            if (n > MAX_REGIMES || !regime_from_menu((int)n, &config.regime)) {
+                fprintf(stderr, "   >> BAD VALUE FOR %s: %s (1-%d)\n", arg, val, regime_model.regime_count);
+                return 2;
+            }
+        } else if (strcmp(arg, "--dd") == 0) {
+            if (!parse_double(arg, val, &x)) return 2;
+            config.max_drawdown_limit = x / 100.0;
+        } else if (strcmp(arg, "--tail") == 0) {
+            if (!parse_double(arg, val, &x)) return 2;
+            mc.tail_nav_ratio = x / 100.0;
+        } else if (strcmp(arg, "--seed") == 0) {
+            if (!parse_long(arg, val, &n)) return 2;
+            if (n < 0) {
+                fprintf(stderr, "   >> BAD VALUE FOR %s: %s\n", arg, val);
+                return 2;
+            }
+            mc.seed = (unsigned long)n;
+        } else if (strcmp(arg, "--regimes") == 0) {
+            continue; // Loaded in main
+        } else if (strcmp(arg, "--vr") == 0) {
+            mc.flags = parse_vr(val);
+            if (mc.flags < 0) return 2;
+        } else {
+            fprintf(stderr, "   >> UNKNOWN OPTION %s\n", arg);
+            return 2;
+        }
+    }
+
+    if (mc.paths < mc_min_paths(mc.flags)) {
+        fprintf(stderr, "   >> TOO FEW PATHS: %d (MINIMUM %d FOR THIS --vr)\n",
+                mc.paths, mc_min_paths(mc.flags));
+        return 2;
+    }
+
+    Asset universe[MAX_ASSETS];
+    market_init_universe(universe);
+    regime_model_bind(&regime_model, universe, UNIVERSE_SIZE);
+    config.model = &regime_model;
+
+    McReport report;
+    if (!mc_run_batch(&config, &mc, &report)) {
+        fprintf(stderr, "   >> BATCH FAILED (LEDGER CORRUPTION OR OUT OF MEMORY)\n");
+        return 1;
+    }
+
+    ui_render_batch_report(&report, &config);
+    return 0;
+}
+
 // --- MAIN RUNTIME ---
 
-int main(void) {
+int main(int argc, char **argv) {
+    if (!load_regimes(argc, argv)) return 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") == 0) return run_batch(argc, argv);
+    }
+
     // 1. INIT
     srand(time(NULL)); // Only for UI jitter, not engine
     ui_render_login();
@@ -110,35 +290,29 @@ int main(void) {
     Portfolio port;
     Asset universe[MAX_ASSETS];
     
-    // Initial Capital: ₹ 10 Crores
-    portfolio_init(&port, TO_MICROS(100000000.00)); 
-    market_init_universe(universe, config.regime);
-
-    // Initial Allocation (Simple 60/40 for demo)
-    // Buy NIFTY
-    port.positions[0].asset_index = 0;
-    port.positions[0].units = 2500; // 2500 Units of NIFTY
-    port.positions[0].cost_basis = universe[0].price;
-    port.positions[0].current_val = universe[0].price * 2500;
-    
-    // Buy BONDS
-    port.positions[1].asset_index = 1;
-    port.positions[1].units = 400000; 
-    port.positions[1].cost_basis = universe[1].price;
-    port.positions[1].current_val = universe[1].price * 400000;
+    portfolio_init(&port, INITIAL_CAPITAL); 
+    market_init_universe(universe);
+    portfolio_open_default_book(&port, universe);
 
-    port.position_count = 2;
-    
-    // Adjust cash
-    currency_t invested = port.positions[0].current_val + port.positions[1].current_val;
-    port.cash_balance -= invested;
+    regime_model_bind(&regime_model, universe, UNIVERSE_SIZE);
+    config.model = &regime_model;
+
+    // Publish to local consumers. The sim runs fine without a feed.
+    if (md_bus_create(&feed_bus, MD_BUS_NAME)) {
+        atexit(feed_shutdown);
+        md_bus_publish(&feed_bus, universe, UNIVERSE_SIZE, config.regime, 0);
+    } else {
+        printf("   [ WARN: MARKET BUS %s UNAVAILABLE, FEED DISABLED ]\n", MD_BUS_NAME);
+    }
 
     // 4. RUN LOOP
     set_conio_terminal_mode(); // ENTER RAW MODE
     
     for (int t = 1; t <= config.duration_months; t++) {
-        // A. Tick Market
-        market_tick(universe, 3, config.regime, t);
+        // A. Tick Market (regime may switch at each month boundary)
+        if (t > 1) config.regime = regime_next(&regime_model, config.regime);
+        market_tick(universe, UNIVERSE_SIZE, &regime_model, config.regime, t);
+        md_bus_publish(&feed_bus, universe, UNIVERSE_SIZE, config.regime, t);
         
         // B. Tick Portfolio
         portfolio_update_valuation(&port, universe);
@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../phonex.h"
+
+// --- SHARED LAYOUT ---
+// Single producer, many consumers. The producer never waits on anyone:
+// each slot carries its own sequence number acting as a seqlock, and
+// consumers that fall more than a ring behind are told so (overrun).
+//
+// Slot protocol (producer):  seq = 0  ->  write frame  ->  seq = N  ->  head = N
+// Slot protocol (consumer):  read seq  ->  copy frame  ->  re-read seq, must still be N
+//
+// Ownership: the producer holds an exclusive flock on the shm object for its
+// lifetime, so a second producer is refused instead of sharing slots. flock
+// belongs to the open file description, not the process: every create opens
+// its own, so a second create in the same process is refused too, and closing
+// unrelated fds (e.g. a consumer's) does not drop it. The lock dies with the
+// process, so a crashed producer's ring can be reclaimed.
+// Each (re)initialisation bumps `epoch`, which tells consumers that sequence
+// numbers restarted.
+
+#define MD_BUS_MAGIC    0x5048584D44425553ULL   // "PHXMDBUS"
+#define MD_BUS_VERSION  2
+#define MD_CACHE_LINE   64
+
+_Static_assert((MD_BUS_SLOTS & (MD_BUS_SLOTS - 1)) == 0, "MD_BUS_SLOTS must be a power of 2");
+
+typedef struct {
+    _Alignas(MD_CACHE_LINE) _Atomic uint64_t seq;
+    MarketTick frame;
+} MdSlot;
+
+struct MdBusRegion {
+    _Atomic uint64_t magic;             // Published last, with release
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t frame_size;
+    _Atomic uint64_t epoch;             // Producer generation, bumped on create
+    _Atomic uint32_t closed;            // Producer shut down cleanly
+
+    _Alignas(MD_CACHE_LINE) _Atomic uint64_t head;  // Last fully published seq
+
+    MdSlot slots[MD_BUS_SLOTS];
+};
+
+static MdSlot *slot_for(struct MdBusRegion *r, uint64_t seq) {
+    return &r->slots[seq & (MD_BUS_SLOTS - 1)];
+}
+
+// --- LIFECYCLE ---
+
+bool md_bus_create(MarketBus *bus, const char *name) {
+    memset(bus, 0, sizeof(*bus));
+    bus->lock_fd = -1;
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return false;
+
+    // One producer per bus. Refuse rather than wipe a live ring.
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        close(fd);
+        return false;
+    }
+
+    if (ftruncate(fd, sizeof(struct MdBusRegion)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    void *mem = mmap(NULL, sizeof(struct MdBusRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    struct MdBusRegion *r = mem;
+
+    // Reset a stale region left by a crashed run. Magic is cleared before the
+    // epoch bump, so a consumer that sees the new epoch waits for magic to be
+    // republished (last, with release) before trusting head.
+    atomic_store_explicit(&r->magic, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&r->epoch, 1, memory_order_release);
+    atomic_thread_fence(memory_order_release); // Epoch before any reset store
+    atomic_store_explicit(&r->closed, 0, memory_order_relaxed);
+    atomic_store_explicit(&r->head, 0, memory_order_relaxed);
+    for (int i = 0; i < MD_BUS_SLOTS; i++) {
+        atomic_store_explicit(&r->slots[i].seq, 0, memory_order_relaxed);
+    }
+    r->version = MD_BUS_VERSION;
+    r->slot_count = MD_BUS_SLOTS;
+    r->frame_size = sizeof(MarketTick);
+    atomic_store_explicit(&r->magic, MD_BUS_MAGIC, memory_order_release);
+
+    bus->region = r;
+    bus->is_producer = true;
+    bus->lock_fd = fd; // Keep open: closing it drops the lock
+    snprintf(bus->name, sizeof(bus->name), "%s", name);
+    return true;
+}
+
+bool md_bus_open(MarketBus *bus, const char *name) {
+    memset(bus, 0, sizeof(*bus));
+    bus->lock_fd = -1;
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct MdBusRegion)) {
+        close(fd);
+        return false;
+    }
+
+    void *mem = mmap(NULL, sizeof(struct MdBusRegion), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return false;
+
+    struct MdBusRegion *r = mem;
+    if (atomic_load_explicit(&r->magic, memory_order_acquire) != MD_BUS_MAGIC ||
+        r->version != MD_BUS_VERSION ||
+        r->slot_count != MD_BUS_SLOTS || r->frame_size != sizeof(MarketTick)) {
+        munmap(mem, sizeof(struct MdBusRegion));
+        return false; // Not ours, or built with a different layout
+    }
+
+    bus->region = r;
+    bus->is_producer = false;
+    snprintf(bus->name, sizeof(bus->name), "%s", name);
+
+    // Late joiners start at the live edge, not at the oldest frame
+    bus->epoch = atomic_load_explicit(&r->epoch, memory_order_acquire);
+    bus->next_seq = atomic_load_explicit(&r->head, memory_order_acquire) + 1;
+    return true;
+}
+
+void md_bus_close(MarketBus *bus) {
+    if (!bus->region) return;
+
+    if (bus->is_producer) {
+        // End of stream: consumers drain what is left, then see MD_READ_CLOSED
+        atomic_store_explicit(&bus->region->closed, 1, memory_order_release);
+    }
+
+    munmap(bus->region, sizeof(struct MdBusRegion));
+    if (bus->is_producer) {
+        shm_unlink(bus->name); // Attached consumers keep their mapping
+        close(bus->lock_fd);
+        bus->lock_fd = -1;
+    }
+    bus->region = NULL;
+}
+
+// --- PRODUCER ---
+
+static MarketTick *begin_write(struct MdBusRegion *r, uint64_t *seq_out) {
+    uint64_t seq = atomic_load_explicit(&r->head, memory_order_relaxed) + 1;
+    MdSlot *slot = slot_for(r, seq);
+
+    // Mark the slot torn before touching the payload
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    *seq_out = seq;
+    return &slot->frame;
+}
+
+static void end_write(struct MdBusRegion *r, uint64_t seq) {
+    atomic_store_explicit(&slot_for(r, seq)->seq, seq, memory_order_release);
+    atomic_store_explicit(&r->head, seq, memory_order_release);
+}
+
+// Writes straight into the ring; no intermediate frame is built.
+void md_bus_publish(MarketBus *bus, const Asset *universe, int count, int regime, int tick) {
+    if (!bus->region || !bus->is_producer) return;
+    if (count > MAX_ASSETS) count = MAX_ASSETS;
+
+    uint64_t seq;
+    MarketTick *f = begin_write(bus->region, &seq);
+
+    f->seq = seq;
+    f->tick = tick;
+    f->count = count;
+    f->regime = regime;
+    for (int i = 0; i < count; i++) {
+        memcpy(f->ticker[i], universe[i].ticker, sizeof(f->ticker[i]));
+        f->price[i] = universe[i].price;
+        f->prev_price[i] = universe[i].prev_price;
+        f->is_illiquid[i] = universe[i].is_illiquid;
+    }
+
+    end_write(bus->region, seq);
+}
+
+// For publishers that already hold a complete frame (tape replay).
+void md_bus_publish_frame(MarketBus *bus, const MarketTick *frame) {
+    if (!bus->region || !bus->is_producer) return;
+
+    uint64_t seq;
+    MarketTick *f = begin_write(bus->region, &seq);
+    memcpy(f, frame, sizeof(*f));
+    f->seq = seq;
+    end_write(bus->region, seq);
+}
+
+// --- CONSUMER ---
+
+// Producer (re)initialised the ring under us. Sequence numbers restarted,
+// so skip to the oldest frame of the new stream and count what was skipped.
+// Until the reset is published, head may still be the old stream's: report
+// EMPTY and keep the old epoch so the next poll retries.
+static MdReadResult resync(MarketBus *bus, uint64_t epoch) {
+    struct MdBusRegion *r = bus->region;
+    if (atomic_load_explicit(&r->magic, memory_order_acquire) != MD_BUS_MAGIC) {
+        return MD_READ_EMPTY;
+    }
+
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    uint64_t oldest = head >= MD_BUS_SLOTS ? head - MD_BUS_SLOTS + 1 : 1;
+
+    bus->epoch = epoch;
+    bus->overruns += oldest - 1;
+    bus->next_seq = oldest;
+    return MD_READ_OVERRUN;
+}
+
+MdReadResult md_bus_poll(MarketBus *bus, MarketTick *out) {
+    struct MdBusRegion *r = bus->region;
+    if (!r) return MD_READ_EMPTY;
+
+    // Closed is set after the final publish, so load it before head
+    uint32_t closed = atomic_load_explicit(&r->closed, memory_order_acquire);
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+
+    uint64_t epoch = atomic_load_explicit(&r->epoch, memory_order_acquire);
+    if (epoch != bus->epoch) return resync(bus, epoch);
+
+    if (head < bus->next_seq) return closed ? MD_READ_CLOSED : MD_READ_EMPTY;
+
+    // Lapped: the frames we wanted have been overwritten
+    if (head - bus->next_seq >= MD_BUS_SLOTS) {
+        uint64_t oldest = head - MD_BUS_SLOTS + 1;
+        bus->overruns += oldest - bus->next_seq;
+        bus->next_seq = oldest;
+        return MD_READ_OVERRUN;
+    }
+
+    uint64_t want = bus->next_seq;
+    MdSlot *slot = slot_for(r, want);
+
+    uint64_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (before != want) {
+        // Producer is rewriting this slot for a later lap
+        bus->overruns++;
+        bus->next_seq = want + 1;
+        return MD_READ_OVERRUN;
+    }
+
+    memcpy(out, &slot->frame, sizeof(*out));
+    atomic_thread_fence(memory_order_acquire);
+
+    uint64_t after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    if (after != want) {
+        // Torn copy, frame was overwritten mid-read
+        bus->overruns++;
+        bus->next_seq = want + 1;
+        return MD_READ_OVERRUN;
+    }
+
+    // Same seq from a restarted producer is a different frame
+    epoch = atomic_load_explicit(&r->epoch, memory_order_acquire);
+    if (epoch != bus->epoch) return resync(bus, epoch);
+
+    bus->next_seq = want + 1;
+    return MD_READ_OK;
+}
@@ -12,13 +12,13 @@ void seed_market(unsigned long seed) {
     _seed = seed;
 }
 
-double det_rand() {
+double det_rand(void) {
     _seed = (_seed * 1103515245 + 12345) & 0x7fffffff;
     return (double)_seed / 2147483648.0;
 }
 
 // Box-Muller transform for Normal Distribution
-double det_normal() {
+double det_normal(void) {
     double u = det_rand();
     double v = det_rand();
     // Prevent log(0)
@@ -28,7 +28,7 @@ double det_normal() {
 
 // --- MARKET LOGIC ---
 
-void market_init_universe(Asset *universe, MarketRegime regime) {
+void market_init_universe(Asset *universe) {
     // 0: NIFTY 50 (Index)
     strcpy(universe[0].ticker, "NIFTY_50");
     strcpy(universe[0].name, "Nifty 50 Index");
@@ -59,68 +59,84 @@ void market_init_universe(Asset *universe, MarketRegime regime) {
     universe[2].correlation_beta = 1.15;
     universe[2].is_illiquid = false;
 
-    // Apply initial Regime modifiers
-    if (regime == REGIME_STAGFLATION) {
-        universe[1].volatility = 0.15; // Bonds get volatile
+    // Regime vol modifiers (e.g. volatile bonds in stagflation) are applied
+    // per tick from the RegimeModel, so they follow regime switches.
+}
+
+void market_tick(Asset *universe, int count, const RegimeModel *m, MarketRegime regime, int tick) {
+    double z[MAX_ASSETS];
+    for (int i = 0; i < count; i++) {
+        z[i] = det_normal();
     }
+    market_tick_z(universe, count, m, regime, tick, z);
 }
 
-void market_tick(Asset *universe, int count, MarketRegime regime, int tick) {
-    // 1. Determine Macro Factors based on Regime
-    double market_drift = 0.0;
-    double market_shock = 0.0;
-
-    switch (regime) {
-        case REGIME_STABLE_GROWTH:
-            market_drift = 0.008; // ~10% annual
-            break;
-        case REGIME_STAGFLATION:
-            market_drift = -0.002;
-            market_shock = -0.01;
-            break;
-        case REGIME_LIQUIDITY_CRUNCH:
-            market_drift = -0.05; // Crash
-            market_shock = -0.02;
-            break;
-        default:
-            market_drift = 0.005;
+// Same as market_tick, but with the standard normal shocks supplied by the
+// caller (one per asset). Lets the Monte Carlo engine drive the market with
+// antithetic or quasi-random draws.
+void market_tick_z(Asset *universe, int count, const RegimeModel *m, MarketRegime regime, int tick, const double *z) {
+    // 1. Fetch the precomputed kernel for this regime
+    const rate_t *k_drift = m->k_drift[regime];
+    const rate_t *k_vol = m->k_vol[regime];
+
+    // 2. Returns for all assets
+    // Geometric Brownian Motion (Discrete)
+    // dS = S * (drift * dt + sigma * dZ)
+    // Drift, beta scaling and forced shock are folded into k_drift, the
+    // monthly vol scaler and regime multipliers into k_vol. No branches.
+    double pct_change[MAX_ASSETS];
+    for (int i = 0; i < count; i++) {
+        pct_change[i] = k_drift[i] + z[i] * k_vol[i];
     }
 
-    // 2. Apply updates to all assets
+    // 3. Apply updates to all assets
     for (int i = 0; i < count; i++) {
         Asset *a = &universe[i];
         a->prev_price = a->price;
 
-        // Geometric Brownian Motion (Discrete)
-        // dS = S * (drift * dt + sigma * dZ)
-        
-        // Calculate drift component
-        double r_drift = market_drift * a->correlation_beta;
-        
-        // Calculate random shock component
-        double shock = det_normal() * a->volatility * 0.28; // Monthly vol scaler
-        
-        // Add forced market shock if correlation is high
-        if (a->correlation_beta > 0.5) {
-            shock += market_shock;
-        }
-
-        // Apply change
-        double pct_change = r_drift + shock;
-        
         // Update Price (using integer math for storage)
-        double new_price_d = FROM_MICROS(a->price) * (1.0 + pct_change);
+        double new_price_d = FROM_MICROS(a->price) * (1.0 + pct_change[i]);
         
         // Hard floor at 0.01
-        if (new_price_d < 0.01) new_price_d = 0.01;
+        new_price_d = fmax(new_price_d, 0.01);
         
         a->price = TO_MICROS(new_price_d);
         
         // Illiquidity Check (Upper/Lower Circuit Mock)
-        if (fabs(pct_change) > 0.10) { 
-            a->is_illiquid = true; // Locked for trading this tick
-        } else {
-            a->is_illiquid = false;
+        // Locked for trading this tick
+        a->is_illiquid = fabs(pct_change[i]) > 0.10;
+    }
+}
+
+// Analytic E[S_T / S_0] for one asset over `ticks` months, starting in
+// `start` and switching regimes per the transition matrix. The shocks are
+// zero-mean and independent of the regime path, so each month contributes
+// its expected gross return. Forward recursion over the regime distribution,
+// O(ticks * regimes^2). Ignores the 0.01 price floor. Used as the control
+// variate mean.
+double market_expected_growth(const RegimeModel *m, int asset, MarketRegime start, int ticks) {
+    int n = m->regime_count;
+    double v[MAX_REGIMES] = {0}; // E[growth so far ; in regime r]
+    v[start] = 1.0;
+
+    for (int t = 0; t < ticks; t++) {
+        double w[MAX_REGIMES] = {0};
+
+        for (int r = 0; r < n; r++) {
+            v[r] *= 1.0 + m->k_drift[r][asset];
+        }
+        if (t == ticks - 1) break;
+
+        // Month boundary: regime transition
+        for (int r = 0; r < n; r++) {
+            for (int s = 0; s < n; s++) {
+                w[s] += v[r] * m->transition[r][s];
+            }
         }
+        memcpy(v, w, sizeof(v));
     }
-}
\ No newline at end of file
+
+    double total = 0.0;
+    for (int r = 0; r < n; r++) total += v[r];
+    return total;
+}
@@ -0,0 +1,283 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../phonex.h"
+
+// --- BATCH MONTE CARLO ---
+// Runs many independent paths of the full engine (market, valuation, audit,
+// RMS) without the UI and reports each estimate with its standard error.
+//
+// Variance reduction (combinable):
+//   VR_ANTITHETIC  each draw is run as a (z, -z) pair; the pair mean is one sample
+//   VR_CONTROL     regress on S_T/S_0 per asset, whose mean is known analytically
+//                  (including over the regime Markov chain)
+//   VR_SOBOL       scrambled Sobol points through a Brownian bridge; the error
+//                  comes from MC_SOBOL_REPLICATES independent scrambles
+
+enum { M_LIQUIDATION, M_TAIL, M_NAV, MC_METRICS };
+
+typedef struct {
+    int count;                  // Assets driven
+    int steps;                  // Months
+    double *z;                  // steps x count shocks, tick-major
+    MarketRegime regime[MAX_TICKS]; // Regime path, shared by antithetic pairs
+    BrownianBridge bridge;
+    SobolSeq sobol;
+} PathGen;
+
+// --- SHOCK GENERATION ---
+
+// regime[t] drives month t + 1; switches happen at month boundaries.
+static void draw_regimes(PathGen *g, const RegimeModel *m, MarketRegime start) {
+    g->regime[0] = start;
+    for (int t = 1; t < g->steps; t++) {
+        g->regime[t] = regime_next(m, g->regime[t - 1]);
+    }
+}
+
+static void draw_pseudo(PathGen *g) {
+    // Tick-major, same order market_tick consumes det_normal
+    for (int k = 0; k < g->steps * g->count; k++) {
+        g->z[k] = det_normal();
+    }
+}
+
+static void draw_sobol(PathGen *g) {
+    double u[MC_SOBOL_DIMS];
+    double zb[MAX_TICKS], dw[MAX_TICKS];
+
+    sobol_next(&g->sobol, u);
+
+    // Dimension order: bridge level first, then asset. The terminal value of
+    // every asset gets a Sobol coordinate before any midpoint does. Levels
+    // past MC_SOBOL_DIMS are padded with pseudo-random draws.
+    for (int i = 0; i < g->count; i++) {
+        for (int k = 0; k < g->steps; k++) {
+            int dim = k * g->count + i;
+            zb[k] = dim < MC_SOBOL_DIMS ? inv_normal(u[dim]) : det_normal();
+        }
+
+        bridge_build(&g->bridge, zb, dw);
+        for (int t = 0; t < g->steps; t++) {
+            g->z[t * g->count + i] = dw[t];
+        }
+    }
+}
+
+// --- PATH ---
+
+// y: MC_METRICS outcomes. x: S_T/S_0 per asset (control variates).
+static bool run_path(const SimConfig *cfg, const McConfig *mc, const PathGen *g,
+                     double *y, double *x) {
+    const int count = g->count;
+    Portfolio port;
+    Asset universe[MAX_ASSETS];
+    SimConfig rms = *cfg;
+
+    portfolio_init(&port, INITIAL_CAPITAL);
+    market_init_universe(universe);
+    portfolio_open_default_book(&port, universe);
+
+    currency_t s0[MAX_ASSETS];
+    for (int i = 0; i < count; i++) s0[i] = universe[i].price;
+
+    // The book is held to the horizon; a breach is recorded, not acted on
+    bool breached = false;
+    for (int t = 1; t <= cfg->duration_months; t++) {
+        rms.regime = g->regime[t - 1];
+        market_tick_z(universe, count, cfg->model, rms.regime, t, &g->z[(t - 1) * count]);
+        portfolio_update_valuation(&port, universe);
+        if (!portfolio_audit(&port)) return false;
+
+        execution_check_constraints(&port, &rms);
+        if (port.status == STATUS_LIQUIDATED || port.status == STATUS_INSOLVENT) {
+            breached = true;
+        }
+    }
+
+    y[M_LIQUIDATION] = breached ? 1.0 : 0.0;
+    y[M_TAIL] = port.nav < INITIAL_CAPITAL * mc->tail_nav_ratio ? 1.0 : 0.0;
+    y[M_NAV] = FROM_MICROS(port.nav);
+
+    for (int i = 0; i < count; i++) {
+        x[i] = (double)universe[i].price / (double)s0[i];
+    }
+    return true;
+}
+
+// --- ESTIMATION ---
+
+// Solves A b = r in place (n x n, row stride MAX_ASSETS). False if singular.
+static bool solve_linear(double A[MAX_ASSETS][MAX_ASSETS], double *r, int n) {
+    for (int c = 0; c < n; c++) {
+        int piv = c;
+        for (int i = c + 1; i < n; i++) {
+            if (fabs(A[i][c]) > fabs(A[piv][c])) piv = i;
+        }
+        if (fabs(A[piv][c]) < 1e-300) return false;
+
+        if (piv != c) {
+            for (int k = 0; k < n; k++) {
+                double tmp = A[c][k]; A[c][k] = A[piv][k]; A[piv][k] = tmp;
+            }
+            double tmp = r[c]; r[c] = r[piv]; r[piv] = tmp;
+        }
+
+        for (int i = c + 1; i < n; i++) {
+            double f = A[i][c] / A[c][c];
+            for (int k = c; k < n; k++) A[i][k] -= f * A[c][k];
+            r[i] -= f * r[c];
+        }
+    }
+
+    for (int c = n - 1; c >= 0; c--) {
+        for (int k = c + 1; k < n; k++) r[c] -= A[c][k] * r[k];
+        r[c] /= A[c][c];
+    }
+    return true;
+}
+
+// Mean and standard error of metric m over `units` samples. Samples are
+// averaged in blocks of `group` first (one block per Sobol scramble) and the
+// error is taken across blocks. With `mu`, applies the regression control
+// variate estimator  y - beta . (x - mu)  with beta fitted on the pooled sample.
+static McEstimate estimate(const double *y, const double *x, const double *mu,
+                           int units, int count, int group, int m) {
+    double beta[MAX_ASSETS] = {0};
+
+    if (mu) {
+        double y_bar = 0.0, x_bar[MAX_ASSETS] = {0};
+        for (int u = 0; u < units; u++) {
+            y_bar += y[u * MC_METRICS + m];
+            for (int i = 0; i < count; i++) x_bar[i] += x[u * count + i];
+        }
+        y_bar /= units;
+        for (int i = 0; i < count; i++) x_bar[i] /= units;
+
+        double sxx[MAX_ASSETS][MAX_ASSETS] = {{0}};
+        for (int u = 0; u < units; u++) {
+            double dy = y[u * MC_METRICS + m] - y_bar;
+            for (int i = 0; i < count; i++) {
+                double dxi = x[u * count + i] - x_bar[i];
+                beta[i] += dxi * dy;
+                for (int k = 0; k < count; k++) {
+                    sxx[i][k] += dxi * (x[u * count + k] - x_bar[k]);
+                }
+            }
+        }
+
+        // Degenerate controls (e.g. zero-vol asset): fall back to plain mean
+        if (!solve_linear(sxx, beta, count)) memset(beta, 0, sizeof(beta));
+    }
+
+    int groups = units / group;
+    double mean = 0.0, m2 = 0.0; // Welford, NAV sums are large
+
+    for (int g = 0; g < groups; g++) {
+        double acc = 0.0;
+        for (int u = g * group; u < (g + 1) * group; u++) {
+            double v = y[u * MC_METRICS + m];
+            if (mu) {
+                for (int i = 0; i < count; i++) v -= beta[i] * (x[u * count + i] - mu[i]);
+            }
+            acc += v;
+        }
+        acc /= group;
+
+        double delta = acc - mean;
+        mean += delta / (g + 1);
+        m2 += delta * (acc - mean);
+    }
+
+    McEstimate e;
+    e.mean = mean;
+    e.std_err = sqrt(m2 / (groups - 1) / groups);
+    return e;
+}
+
+// --- DRIVER ---
+
+// Fewest paths that still give a standard error: two samples, or one per
+// scramble with Sobol. Antithetic pairs count as one sample.
+int mc_min_paths(int flags) {
+    int per_unit = (flags & VR_ANTITHETIC) ? 2 : 1;
+    return per_unit * ((flags & VR_SOBOL) ? MC_SOBOL_REPLICATES : 2);
+}
+
+bool mc_run_batch(const SimConfig *cfg, const McConfig *mc, McReport *out) {
+    const int count = UNIVERSE_SIZE;
+    const bool anti = mc->flags & VR_ANTITHETIC;
+    const bool sobol = mc->flags & VR_SOBOL;
+
+    if (cfg->duration_months < 1 || cfg->duration_months > MAX_TICKS) return false;
+    if (mc->paths < mc_min_paths(mc->flags)) return false;
+
+    int paths = mc->paths > MC_MAX_PATHS ? MC_MAX_PATHS : mc->paths;
+    int per_unit = anti ? 2 : 1;
+    int units = paths / per_unit;
+    int group = 1;
+
+    if (sobol) {
+        // Net balance only holds for power-of-two blocks per scramble
+        while (group * 2 <= units / MC_SOBOL_REPLICATES) group *= 2;
+        units = group * MC_SOBOL_REPLICATES;
+    }
+
+    PathGen gen;
+    gen.count = count;
+    gen.steps = cfg->duration_months;
+    gen.z = malloc(sizeof(double) * gen.steps * count);
+    double *y = malloc(sizeof(double) * units * MC_METRICS);
+    double *x = malloc(sizeof(double) * units * count);
+    if (!gen.z || !y || !x) {
+        free(gen.z); free(y); free(x);
+        return false;
+    }
+
+    seed_market(mc->seed);
+    if (sobol) bridge_init(&gen.bridge, gen.steps);
+
+    bool ok = true;
+    for (int u = 0; u < units && ok; u++) {
+        double *yu = &y[u * MC_METRICS];
+        double *xu = &x[u * count];
+
+        if (sobol) {
+            if (u % group == 0) sobol_init(&gen.sobol, true); // Fresh scramble
+            draw_sobol(&gen);
+        } else {
+            draw_pseudo(&gen);
+        }
+        draw_regimes(&gen, cfg->model, cfg->regime);
+
+        ok = run_path(cfg, mc, &gen, yu, xu);
+
+        if (ok && anti) {
+            double y2[MC_METRICS], x2[MAX_ASSETS];
+            for (int k = 0; k < gen.steps * count; k++) gen.z[k] = -gen.z[k];
+
+            ok = run_path(cfg, mc, &gen, y2, x2);
+            for (int m = 0; m < MC_METRICS; m++) yu[m] = 0.5 * (yu[m] + y2[m]);
+            for (int i = 0; i < count; i++) xu[i] = 0.5 * (xu[i] + x2[i]);
+        }
+    }
+
+    if (ok) {
+        double mu[MAX_ASSETS];
+        for (int i = 0; i < count; i++) {
+            mu[i] = market_expected_growth(cfg->model, i, cfg->regime, cfg->duration_months);
+        }
+        const double *cv = (mc->flags & VR_CONTROL) ? mu : NULL;
+
+        out->paths = units * per_unit;
+        out->flags = mc->flags;
+        out->p_liquidation = estimate(y, x, cv, units, count, group, M_LIQUIDATION);
+        out->p_tail = estimate(y, x, cv, units, count, group, M_TAIL);
+        out->terminal_nav = estimate(y, x, cv, units, count, group, M_NAV);
+    }
+
+    free(gen.z);
+    free(y);
+    free(x);
+    return ok;
+}
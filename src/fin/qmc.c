@@ -0,0 +1,211 @@
+#include <math.h>
+#include <string.h>
+#include "../phonex.h"
+
+// --- SOBOL DIRECTION NUMBERS ---
+// Primitive polynomials and initial direction numbers for dimensions 2..21
+// (Joe & Kuo, new-joe-kuo-6.21201). Dimension 1 is van der Corput.
+// Polynomial: degree s, inner coefficients packed in a.
+
+typedef struct {
+    int s;
+    uint32_t a;
+    uint32_t m[7];
+} SobolPoly;
+
+static const SobolPoly SOBOL_POLY[MC_SOBOL_DIMS - 1] = {
+    {1,  0, {1}},
+    {2,  1, {1, 3}},
+    {3,  1, {1, 3, 1}},
+    {3,  2, {1, 1, 1}},
+    {4,  1, {1, 1, 3, 3}},
+    {4,  4, {1, 3, 5, 13}},
+    {5,  2, {1, 1, 5, 5, 17}},
+    {5,  4, {1, 1, 5, 5, 5}},
+    {5,  7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6,  1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7,  1, {1, 3, 7, 11, 23, 15, 103}},
+    {7,  4, {1, 3, 7, 13, 13, 15, 69}}
+};
+
+static uint32_t det_rand_u32(void) {
+    // det_rand yields 31 bits, stitch two draws
+    uint32_t hi = (uint32_t)(det_rand() * 65536.0);
+    uint32_t lo = (uint32_t)(det_rand() * 65536.0);
+    return (hi << 16) | lo;
+}
+
+static int parity32(uint32_t x) {
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return x & 1;
+}
+
+// --- SOBOL SEQUENCE ---
+
+void sobol_init(SobolSeq *s, bool scramble) {
+    memset(s, 0, sizeof(*s));
+
+    // Dimension 1: v_k = 2^(32-k)
+    for (int k = 0; k < 32; k++) {
+        s->v[0][k] = 1u << (31 - k);
+    }
+
+    // Remaining dimensions: Bratley-Fox recurrence
+    for (int d = 1; d < MC_SOBOL_DIMS; d++) {
+        const SobolPoly *p = &SOBOL_POLY[d - 1];
+        uint32_t *v = s->v[d];
+
+        for (int k = 0; k < p->s; k++) {
+            v[k] = p->m[k] << (31 - k);
+        }
+        for (int k = p->s; k < 32; k++) {
+            v[k] = v[k - p->s] ^ (v[k - p->s] >> p->s);
+            for (int j = 1; j < p->s; j++) {
+                if ((p->a >> (p->s - 1 - j)) & 1) v[k] ^= v[k - j];
+            }
+        }
+    }
+
+    if (!scramble) return;
+
+    // Matousek linear scramble + random digital shift. L is lower triangular
+    // with a unit diagonal (bit 31 = most significant row/column), applied to
+    // every direction number so the Gray code walk stays cheap.
+    for (int d = 0; d < MC_SOBOL_DIMS; d++) {
+        uint32_t L[32];
+        for (int i = 0; i < 32; i++) {
+            uint32_t above = i == 0 ? 0 : ~((1u << (32 - i)) - 1); // columns j < i
+            L[i] = (det_rand_u32() & above) | (1u << (31 - i));
+        }
+
+        for (int k = 0; k < 32; k++) {
+            uint32_t in = s->v[d][k], out = 0;
+            for (int i = 0; i < 32; i++) {
+                out |= (uint32_t)parity32(L[i] & in) << (31 - i);
+            }
+            s->v[d][k] = out;
+        }
+
+        s->shift[d] = det_rand_u32();
+    }
+}
+
+// Next point in Gray code order, written as MC_SOBOL_DIMS uniforms in (0,1).
+// Emits the current point before advancing, so a block of 2^m calls from a
+// fresh sequence is exactly X_0..X_(2^m - 1), a (t,m,s)-net. The origin is
+// harmless once shifted.
+void sobol_next(SobolSeq *s, double *u) {
+    for (int d = 0; d < MC_SOBOL_DIMS; d++) {
+        u[d] = ((double)(s->x[d] ^ s->shift[d]) + 0.5) / 4294967296.0;
+    }
+
+    // Advance: flip the direction number at the lowest zero bit of the index
+    int c = 0;
+    uint32_t n = s->index++;
+    while (n & 1) {
+        n >>= 1;
+        c++;
+    }
+
+    for (int d = 0; d < MC_SOBOL_DIMS; d++) {
+        s->x[d] ^= s->v[d][c];
+    }
+}
+
+// --- BROWNIAN BRIDGE ---
+// Orders the path construction terminal point first, then midpoints, so the
+// leading (best distributed) Sobol dimensions carry most of the variance.
+
+void bridge_init(BrownianBridge *b, int steps) {
+    int map[MAX_TICKS] = {0}; // 0 = not yet placed
+
+    b->steps = steps;
+    map[steps - 1] = 1;
+    b->bridge_idx[0] = steps - 1;
+    b->stddev[0] = sqrt((double)steps);
+    b->left_w[0] = b->right_w[0] = 0.0;
+    b->left_idx[0] = b->right_idx[0] = 0;
+
+    for (int i = 1, j = 0; i < steps; i++) {
+        while (map[j]) j++;
+        int k = j;
+        while (!map[k]) k++;
+
+        // Bisect the unfilled run [j, k-1], anchored on k and on j-1
+        int l = j + ((k - 1 - j) >> 1);
+        map[l] = i + 1;
+
+        b->bridge_idx[i] = l;
+        b->left_idx[i] = j;
+        b->right_idx[i] = k;
+        b->left_w[i] = (double)(k - l) / (k + 1 - j);
+        b->right_w[i] = (double)(l + 1 - j) / (k + 1 - j);
+        b->stddev[i] = sqrt((double)(l + 1 - j) * (k - l) / (k + 1 - j));
+
+        j = k + 1;
+        if (j >= steps) j = 0;
+    }
+}
+
+// z: standard normals in bridge order. dw: unit-variance increments per step.
+void bridge_build(const BrownianBridge *b, const double *z, double *dw) {
+    double w[MAX_TICKS];
+
+    w[b->steps - 1] = b->stddev[0] * z[0];
+    for (int i = 1; i < b->steps; i++) {
+        int j = b->left_idx[i], k = b->right_idx[i], l = b->bridge_idx[i];
+        double left = j > 0 ? b->left_w[i] * w[j - 1] : 0.0;
+        w[l] = left + b->right_w[i] * w[k] + b->stddev[i] * z[i];
+    }
+
+    dw[0] = w[0];
+    for (int t = 1; t < b->steps; t++) {
+        dw[t] = w[t] - w[t - 1];
+    }
+}
+
+// --- INVERSE NORMAL CDF ---
+// Acklam's rational approximation, relative error < 1.2e-9.
+
+double inv_normal(double u) {
+    static const double a[] = { -3.969683028665376e+01,  2.209460984245205e+02,
+                                -2.759285104469687e+02,  1.383577518672690e+02,
+                                -3.066479806614716e+01,  2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01,  1.615858368580409e+02,
+                                -1.556989798598866e+02,  6.680131188771972e+01,
+                                -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01,
+                                -2.400758277161838e+00, -2.549732539343734e+00,
+                                 4.374664141464968e+00,  2.938163982698783e+00 };
+    static const double d[] = {  7.784695709041462e-03,  3.224671290700398e-01,
+                                 2.445134137142996e+00,  3.754408661907416e+00 };
+    const double p_low = 0.02425;
+
+    if (u < p_low) {
+        double q = sqrt(-2.0 * log(u));
+        return (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+               ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+    }
+    if (u > 1.0 - p_low) {
+        double q = sqrt(-2.0 * log(1.0 - u));
+        return -(((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+                ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+    }
+
+    double q = u - 0.5;
+    double r = q * q;
+    return (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5]) * q /
+           (((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1.0);
+}
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../phonex.h"
+
+// --- REGIME MODEL ---
+// Regimes evolve as a Markov chain sampled once per month with the
+// deterministic RNG. Parameters are folded into flat per (regime, asset)
+// tables once per run so market_tick never looks at regime specs.
+
+#define MONTHLY_VOL_SCALER  0.28
+#define HIGH_BETA           0.5     // Assets above this take the forced shock
+
+static void set_spec(RegimeSpec *s, const char *name, rate_t drift, rate_t shock, rate_t vol_scale) {
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->drift = drift;
+    s->shock = shock;
+    s->vol_scale = vol_scale;
+    for (int c = 0; c < CLASS_COUNT; c++) s->class_vol[c] = 1.0;
+}
+
+// Built-in regimes. Every regime is absorbing, i.e. a single fixed regime
+// per run, until a file says otherwise.
+void regime_model_default(RegimeModel *m) {
+    memset(m, 0, sizeof(*m));
+    m->regime_count = REGIME_CUSTOM + 1;
+
+    set_spec(&m->spec[REGIME_STABLE_GROWTH],    "GROWTH",        0.008,  0.00, 1.0); // ~10% annual
+    set_spec(&m->spec[REGIME_STAGFLATION],      "STAGFLATION",  -0.002, -0.01, 1.0);
+    set_spec(&m->spec[REGIME_LIQUIDITY_CRUNCH], "LIQ CRUNCH",   -0.05,  -0.02, 1.0); // Crash
+    set_spec(&m->spec[REGIME_GLOBAL_SHOCK],     "GLOBAL SHOCK", -0.03,  -0.03, 1.5);
+    set_spec(&m->spec[REGIME_CUSTOM],           "CUSTOM",        0.005,  0.00, 1.0);
+
+    // Bonds get volatile: 4% -> 15%
+    m->spec[REGIME_STAGFLATION].class_vol[CLASS_GOVT_BOND] = 0.15 / 0.04;
+    m->spec[REGIME_GLOBAL_SHOCK].class_vol[CLASS_GOLD] = 0.8; // Haven
+
+    for (int r = 0; r < MAX_REGIMES; r++) {
+        m->transition[r][r] = 1.0;
+    }
+}
+
+// --- FILE LOADER ---
+// Starts from the built-in model, then applies the file:
+//
+//     # regime <id> <name> <drift> <shock> <vol_scale> [cash eq gsec corp gold]
+//     regime 5 SOFT_LANDING 0.004 0.0 0.8
+//     # matrix <from> <p(from->0)> <p(from->1)> ...
+//     matrix 0 0.95 0.04 0 0 0 0.01
+//
+// Ids 0-4 override the built-ins, 5+ add custom regimes (contiguous).
+// Rows not given stay absorbing. Each given row must sum to 1.
+
+static bool load_error(const char *path, int line_no, const char *msg) {
+    fprintf(stderr, "   >> REGIME FILE %s:%d: %s\n", path, line_no, msg);
+    return false;
+}
+
+static bool row_error(const char *path, int row, const char *msg) {
+    fprintf(stderr, "   >> REGIME FILE %s: REGIME %d: %s\n", path, row, msg);
+    return false;
+}
+
+bool regime_model_load(RegimeModel *m, const char *path) {
+    regime_model_default(m);
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    bool defined[MAX_REGIMES] = {0};
+    bool row_given[MAX_REGIMES] = {0};
+    for (int r = 0; r <= REGIME_CUSTOM; r++) defined[r] = true;
+
+    char line[512];
+    int line_no = 0;
+    bool ok = true;
+
+    while (ok && fgets(line, sizeof(line), f)) {
+        line_no++;
+
+        char key[16];
+        int id, used;
+        if (sscanf(line, " %15s", key) != 1 || key[0] == '#') continue;
+
+        if (strcmp(key, "regime") == 0) {
+            RegimeSpec spec;
+            char name[16];
+            if (sscanf(line, " regime %d %15s %lf %lf %lf%n", &id, name,
+                       &spec.drift, &spec.shock, &spec.vol_scale, &used) != 5) {
+                ok = load_error(path, line_no, "EXPECTED: regime <id> <name> <drift> <shock> <vol_scale>");
+                break;
+            }
+            if (id < 0 || id >= MAX_REGIMES) {
+                ok = load_error(path, line_no, "REGIME ID OUT OF RANGE");
+                break;
+            }
+            if (!isfinite(spec.drift) || !isfinite(spec.shock) || !(spec.vol_scale >= 0.0) ||
+                !isfinite(spec.vol_scale)) {
+                ok = load_error(path, line_no, "NON-FINITE OR NEGATIVE REGIME PARAMETER");
+                break;
+            }
+
+            set_spec(&m->spec[id], name, spec.drift, spec.shock, spec.vol_scale);
+
+            // Optional per-class vol multipliers, in AssetClass order
+            char *p = line + used;
+            for (int c = 0; c < CLASS_COUNT; c++) {
+                char *end;
+                double v = strtod(p, &end);
+                if (end == p) break;
+                if (!(v >= 0.0) || !isfinite(v)) {
+                    ok = load_error(path, line_no, "NON-FINITE OR NEGATIVE VOL MULTIPLIER");
+                    break;
+                }
+                m->spec[id].class_vol[c] = v;
+                p = end;
+            }
+            if (!ok) break;
+
+            defined[id] = true;
+            if (id + 1 > m->regime_count) m->regime_count = id + 1;
+
+        } else if (strcmp(key, "matrix") == 0) {
+            if (sscanf(line, " matrix %d%n", &id, &used) != 1 || id < 0 || id >= MAX_REGIMES) {
+                ok = load_error(path, line_no, "EXPECTED: matrix <from> <p0> <p1> ...");
+                break;
+            }
+
+            char *p = line + used;
+            for (int s = 0; s < MAX_REGIMES; s++) {
+                char *end;
+                double v = strtod(p, &end);
+                if (end != p && !isfinite(v)) {
+                    ok = load_error(path, line_no, "NON-FINITE TRANSITION PROBABILITY");
+                    break;
+                }
+                m->transition[id][s] = end == p ? 0.0 : v;
+                p = end;
+            }
+            if (!ok) break;
+            row_given[id] = true;
+
+        } else {
+            ok = load_error(path, line_no, "UNKNOWN KEYWORD");
+        }
+    }
+    fclose(f);
+    if (!ok) return false;
+
+    // Validate the chain
+    for (int r = 0; r < MAX_REGIMES; r++) {
+        if (r < m->regime_count && !defined[r]) {
+            return row_error(path, r, "UNDEFINED, REGIME IDS MUST BE CONTIGUOUS");
+        }
+        if (!row_given[r]) continue;
+        if (r >= m->regime_count) {
+            return row_error(path, r, "MATRIX ROW FOR UNDEFINED REGIME");
+        }
+
+        double sum = 0.0;
+        for (int s = 0; s < MAX_REGIMES; s++) {
+            double p = m->transition[r][s];
+            // Written to fail on NaN as well
+            if (!(p >= 0.0) || (s >= m->regime_count && p > 0.0)) {
+                return row_error(path, r, "NEGATIVE OR OUT OF RANGE TRANSITION");
+            }
+            sum += p;
+        }
+        if (!(fabs(sum - 1.0) <= 1e-6)) {
+            return row_error(path, r, "MATRIX ROW DOES NOT SUM TO 1");
+        }
+    }
+    return true;
+}
+
+// --- KERNEL PRECOMPUTATION ---
+
+void regime_model_bind(RegimeModel *m, const Asset *universe, int count) {
+    m->asset_count = count;
+
+    for (int r = 0; r < m->regime_count; r++) {
+        const RegimeSpec *s = &m->spec[r];
+
+        for (int i = 0; i < count; i++) {
+            const Asset *a = &universe[i];
+            double shock = a->correlation_beta > HIGH_BETA ? s->shock : 0.0;
+
+            m->k_drift[r][i] = s->drift * a->correlation_beta + shock;
+            m->k_vol[r][i] = a->volatility * MONTHLY_VOL_SCALER * s->vol_scale * s->class_vol[a->type];
+        }
+
+        double acc = 0.0;
+        for (int t = 0; t < m->regime_count; t++) {
+            acc += m->transition[r][t];
+            m->cum_transition[r][t] = acc;
+        }
+
+        // Absorb rounding from the last reachable regime on
+        int last = m->regime_count - 1;
+        while (last > 0 && m->transition[r][last] <= 0.0) last--;
+        for (int t = last; t < m->regime_count; t++) m->cum_transition[r][t] = 1.0;
+    }
+}
+
+// --- SAMPLING ---
+
+MarketRegime regime_next(const RegimeModel *m, MarketRegime current) {
+    // Absorbing states draw nothing, keeping fixed-regime runs on the same
+    // RNG stream as before regimes could switch
+    if (m->transition[current][current] >= 1.0) return current;
+
+    double u = det_rand();
+    const rate_t *cum = m->cum_transition[current];
+
+    int next = 0;
+    for (int s = 0; s < m->regime_count - 1; s++) {
+        next += u >= cum[s];
+    }
+    return (MarketRegime)next;
+}
+
+const char *regime_name(const RegimeModel *m, MarketRegime r) {
+    return m->spec[r].name;
+}
@@ -22,8 +22,18 @@
 
 #define CURRENCY_SCALE      1000000 
 #define MAX_ASSETS          16      
+#define UNIVERSE_SIZE       3       // Assets seeded by market_init_universe
+#define MAX_REGIMES         8       // Built-in regimes + custom ones from file
 #define MAX_TICKS           360
 #define UI_TICK_DELAY_MS    250     
+#define INITIAL_CAPITAL     TO_MICROS(100000000.00) // INR 10 Crores
+
+#define MC_MAX_PATHS        262144          // Batch Monte Carlo path cap
+#define MC_SOBOL_DIMS       21              // Sobol dims with direction numbers
+#define MC_SOBOL_REPLICATES 16              // Independent scrambles per QMC batch
+
+#define MD_BUS_NAME         "/phonex_md"    // POSIX shm object for the market feed
+#define MD_BUS_SLOTS        1024            // Ring depth (power of 2)
 
 /* --- CORE TYPES ----------------------------------------------------------------- */
 
@@ -46,7 +56,8 @@ typedef enum {
     CLASS_NIFTY_EQ,
     CLASS_GOVT_BOND,
     CLASS_CORP_DEBT,
-    CLASS_GOLD
+    CLASS_GOLD,
+    CLASS_COUNT
 } AssetClass;
 
 typedef enum {
@@ -98,7 +109,29 @@ typedef struct {
 } Portfolio;
 
 typedef struct {
-    MarketRegime regime;
+    char name[16];
+    rate_t drift;                       // Monthly market drift, scaled by beta
+    rate_t shock;                       // Forced shock on high-beta assets
+    rate_t vol_scale;                   // Multiplier on every asset's vol
+    rate_t class_vol[CLASS_COUNT];      // Extra vol multiplier per asset class
+} RegimeSpec;
+
+typedef struct {
+    int regime_count;
+    RegimeSpec spec[MAX_REGIMES];
+    rate_t transition[MAX_REGIMES][MAX_REGIMES]; // P(from -> to) per month
+
+    // Flat kernels, filled by regime_model_bind for one universe.
+    // Per tick: pct_change[i] = k_drift[r][i] + z[i] * k_vol[r][i]
+    int asset_count;
+    rate_t cum_transition[MAX_REGIMES][MAX_REGIMES];
+    rate_t k_drift[MAX_REGIMES][MAX_ASSETS];
+    rate_t k_vol[MAX_REGIMES][MAX_ASSETS];
+} RegimeModel;
+
+typedef struct {
+    MarketRegime regime;                // Current regime, advanced monthly
+    const RegimeModel *model;
     int duration_months;
     
     rate_t max_drawdown_limit;
@@ -109,6 +142,88 @@ typedef struct {
     bool allow_margin;              
 } SimConfig;
 
+/* --- MONTE CARLO ---------------------------------------------------------------- */
+
+typedef enum {
+    VR_NONE       = 0,
+    VR_ANTITHETIC = 1 << 0,             // Mirrored path pairs (z, -z)
+    VR_CONTROL    = 1 << 1,             // Regress on analytic E[S_T] per asset
+    VR_SOBOL      = 1 << 2              // Scrambled Sobol + Brownian bridge
+} VarianceReduction;
+
+typedef struct {
+    int paths;
+    int flags;                          // VarianceReduction bitmask
+    unsigned long seed;
+    rate_t tail_nav_ratio;              // Tail event: NAV_T below this x initial
+} McConfig;
+
+typedef struct {
+    double mean;
+    double std_err;
+} McEstimate;
+
+typedef struct {
+    int paths;                          // Paths actually simulated
+    int flags;
+    McEstimate p_liquidation;           // P(drawdown limit or insolvency hit)
+    McEstimate p_tail;                  // P(NAV_T < tail_nav_ratio x initial)
+    McEstimate terminal_nav;            // E[NAV_T], INR
+} McReport;
+
+typedef struct {
+    uint32_t v[MC_SOBOL_DIMS][32];      // Direction numbers (scrambled)
+    uint32_t x[MC_SOBOL_DIMS];          // Current point, Gray code order
+    uint32_t shift[MC_SOBOL_DIMS];      // Random digital shift
+    uint32_t index;
+} SobolSeq;
+
+typedef struct {
+    int steps;
+    int bridge_idx[MAX_TICKS];
+    int left_idx[MAX_TICKS];
+    int right_idx[MAX_TICKS];
+    double left_w[MAX_TICKS];
+    double right_w[MAX_TICKS];
+    double stddev[MAX_TICKS];
+} BrownianBridge;
+
+/* --- MARKET DATA BUS ------------------------------------------------------------ */
+
+// One published frame: a snapshot of the whole universe after a market tick.
+// Lives directly inside the shared ring; consumers copy it out under the
+// slot's sequence guard.
+typedef struct {
+    uint64_t seq;                       // Bus sequence (1-based, gapless)
+    int32_t tick;
+    int32_t count;
+    int32_t regime;
+    char ticker[MAX_ASSETS][12];
+    currency_t price[MAX_ASSETS];
+    currency_t prev_price[MAX_ASSETS];
+    uint8_t is_illiquid[MAX_ASSETS];
+} MarketTick;
+
+typedef enum {
+    MD_READ_EMPTY,                      // Nothing new since last poll
+    MD_READ_OK,                         // Frame copied out
+    MD_READ_OVERRUN,                    // Lapped or producer restarted, skipped ahead
+    MD_READ_CLOSED                      // Producer closed the bus, ring drained
+} MdReadResult;
+
+struct MdBusRegion;                     // Shared layout, private to md_bus.c
+
+typedef struct {
+    struct MdBusRegion *region;
+    char name[64];
+    bool is_producer;
+    int lock_fd;                        // Producer: holds the ownership lock
+
+    uint64_t epoch;                     // Consumer: producer generation seen
+    uint64_t next_seq;                  // Consumer cursor
+    uint64_t overruns;                  // Frames lost to overruns
+} MarketBus;
+
 /* --- MACROS --------------------------------------------------------------------- */
 
 #define TO_MICROS(x) ((currency_t)((x) * CURRENCY_SCALE))
@@ -121,18 +236,48 @@ typedef struct {
 void phonex_init(void);
 void phonex_teardown(void);
 
-void market_init_universe(Asset *universe, MarketRegime regime);
-void market_tick(Asset *universe, int count, MarketRegime regime, int tick);
+void seed_market(unsigned long seed);
+double det_rand(void);
+double det_normal(void);
+
+void market_init_universe(Asset *universe);
+void market_tick(Asset *universe, int count, const RegimeModel *m, MarketRegime regime, int tick);
+void market_tick_z(Asset *universe, int count, const RegimeModel *m, MarketRegime regime, int tick, const double *z);
+double market_expected_growth(const RegimeModel *m, int asset, MarketRegime start, int ticks);
+
+void regime_model_default(RegimeModel *m);
+bool regime_model_load(RegimeModel *m, const char *path);
+void regime_model_bind(RegimeModel *m, const Asset *universe, int count);
+MarketRegime regime_next(const RegimeModel *m, MarketRegime current);
+const char *regime_name(const RegimeModel *m, MarketRegime r);
+
+void sobol_init(SobolSeq *s, bool scramble);
+void sobol_next(SobolSeq *s, double *u);
+void bridge_init(BrownianBridge *b, int steps);
+void bridge_build(const BrownianBridge *b, const double *z, double *dw);
+double inv_normal(double u);
+
+int mc_min_paths(int flags);
+bool mc_run_batch(const SimConfig *cfg, const McConfig *mc, McReport *out);
 
 void portfolio_init(Portfolio *p, currency_t initial_capital);
+void portfolio_open_default_book(Portfolio *p, Asset *universe);
 void portfolio_update_valuation(Portfolio *p, Asset *universe);
 bool portfolio_audit(Portfolio *p); 
 
 void execution_check_constraints(Portfolio *p, SimConfig *cfg);
 void execution_force_liquidate(Portfolio *p, Asset *universe);
 
+bool md_bus_create(MarketBus *bus, const char *name);
+bool md_bus_open(MarketBus *bus, const char *name);
+void md_bus_close(MarketBus *bus);
+void md_bus_publish(MarketBus *bus, const Asset *universe, int count, int regime, int tick);
+void md_bus_publish_frame(MarketBus *bus, const MarketTick *frame);
+MdReadResult md_bus_poll(MarketBus *bus, MarketTick *out);
+
 void ui_render_login(void);
 void ui_render_frame(Portfolio *p, Asset *universe, SimConfig *cfg, int tick);
 void ui_get_config(SimConfig *cfg);
+void ui_render_batch_report(const McReport *r, const SimConfig *cfg);
 
 #endif // PHONEX_H
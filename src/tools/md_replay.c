@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE 199309L // For nanosleep
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../phonex.h"
+
+// --- TAPE REPLAY PUBLISHER ---
+// Stand-in for the engine: replays a recorded tape onto the market data bus
+// so consumers can be exercised without running a simulation.
+//
+// Tape format, one asset per line, lines sharing a tick form one frame:
+//     <tick> <ticker> <price_inr> [<regime>]
+// Blank lines and lines starting with '#' are ignored. md_tap emits this
+// format, so a live session can be recorded and replayed.
+
+#define TAPE_MAX_TICKERS 64 // Distinct tickers tracked; extras publish prev = price
+
+static void sleep_ms(long ms) {
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+// Last published price per ticker, so prev_price survives tapes that list
+// assets in a different order (or a different subset) from tick to tick.
+typedef struct {
+    int count;
+    char ticker[TAPE_MAX_TICKERS][12];
+    currency_t price[TAPE_MAX_TICKERS];
+} LastPrices;
+
+static currency_t *last_price_for(LastPrices *lp, const char *ticker) {
+    for (int i = 0; i < lp->count; i++) {
+        if (strcmp(lp->ticker[i], ticker) == 0) return &lp->price[i];
+    }
+    if (lp->count >= TAPE_MAX_TICKERS) return NULL;
+
+    int i = lp->count++;
+    memcpy(lp->ticker[i], ticker, sizeof(lp->ticker[i]));
+    lp->price[i] = 0;
+    return &lp->price[i];
+}
+
+static void flush_frame(MarketBus *bus, MarketTick *frame, LastPrices *last, long delay_ms) {
+    if (frame->count == 0) return;
+
+    for (int i = 0; i < frame->count; i++) {
+        currency_t *prev = last_price_for(last, frame->ticker[i]);
+        frame->prev_price[i] = prev && *prev ? *prev : frame->price[i];
+        if (prev) *prev = frame->price[i];
+    }
+
+    // Pace before publishing so consumers that attach at startup see frame 1
+    if (delay_ms > 0) sleep_ms(delay_ms);
+    md_bus_publish_frame(bus, frame);
+
+    frame->count = 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <tape> [delay_ms] [bus_name]\n", argv[0]);
+        return 2;
+    }
+
+    long delay_ms = argc > 2 ? atol(argv[2]) : UI_TICK_DELAY_MS;
+    const char *bus_name = argc > 3 ? argv[3] : MD_BUS_NAME;
+
+    FILE *tape = fopen(argv[1], "r");
+    if (!tape) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    MarketBus bus;
+    if (!md_bus_create(&bus, bus_name)) {
+        fprintf(stderr, "FATAL: CANNOT CREATE MARKET BUS %s\n", bus_name);
+        fclose(tape);
+        return 1;
+    }
+
+    MarketTick frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.tick = -1;
+
+    LastPrices last = {0};
+    char line[256];
+    int line_no = 0;
+    long frames = 0;
+
+    while (fgets(line, sizeof(line), tape)) {
+        line_no++;
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        int tick, regime = 0;
+        char ticker[12] = {0};
+        double price;
+        int n = sscanf(line, "%d %11s %lf %d", &tick, ticker, &price, &regime);
+        if (n < 3) {
+            fprintf(stderr, "WARN: TAPE LINE %d MALFORMED, SKIPPED\n", line_no);
+            continue;
+        }
+
+        if (tick != frame.tick) {
+            if (frame.count > 0) frames++;
+            flush_frame(&bus, &frame, &last, delay_ms);
+            frame.tick = tick;
+        }
+
+        if (frame.count >= MAX_ASSETS) continue;
+
+        int i = frame.count++;
+        memcpy(frame.ticker[i], ticker, sizeof(frame.ticker[i])); // sscanf terminated it
+        frame.price[i] = (currency_t)llround(price * CURRENCY_SCALE);
+        frame.is_illiquid[i] = 0;
+        frame.regime = regime;
+    }
+
+    if (frame.count > 0) frames++;
+    flush_frame(&bus, &frame, &last, delay_ms);
+
+    fclose(tape);
+    printf("   >> REPLAYED %ld FRAMES ON %s\n", frames, bus_name);
+
+    md_bus_close(&bus);
+    return 0;
+}
@@ -0,0 +1,57 @@
+#define _POSIX_C_SOURCE 199309L // For nanosleep
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../phonex.h"
+
+// --- MARKET BUS TAP ---
+// Minimal consumer: attaches to the bus and prints every frame in tape
+// format (see md_replay.c). Overruns are reported on stderr. Exits when the
+// producer closes the bus.
+
+int main(int argc, char **argv) {
+    long max_frames = argc > 1 ? atol(argv[1]) : 0; // 0 = run forever
+    const char *bus_name = argc > 2 ? argv[2] : MD_BUS_NAME;
+
+    MarketBus bus;
+    struct timespec idle = { 0, 1000000L }; // 1ms poll backoff
+
+    // Wait for a producer to come up
+    while (!md_bus_open(&bus, bus_name)) {
+        nanosleep(&idle, NULL);
+    }
+
+    MarketTick frame;
+    long frames = 0;
+    uint64_t reported = 0; // Overruns already reported
+
+    bool live = true;
+    while (live && (max_frames == 0 || frames < max_frames)) {
+        switch (md_bus_poll(&bus, &frame)) {
+            case MD_READ_OK:
+                for (int i = 0; i < frame.count; i++) {
+                    currency_t p = frame.price[i];
+                    printf("%d %s %lld.%06lld %d\n", frame.tick, frame.ticker[i],
+                           (long long)(p / CURRENCY_SCALE), (long long)(p % CURRENCY_SCALE),
+                           frame.regime);
+                }
+                fflush(stdout);
+                frames++;
+                break;
+            case MD_READ_OVERRUN:
+                fprintf(stderr, "WARN: OVERRUN, %llu FRAMES LOST (%llu TOTAL)\n",
+                        (unsigned long long)(bus.overruns - reported), (unsigned long long)bus.overruns);
+                reported = bus.overruns;
+                break;
+            case MD_READ_EMPTY:
+                nanosleep(&idle, NULL);
+                break;
+            case MD_READ_CLOSED:
+                live = false;
+                break;
+        }
+    }
+
+    md_bus_close(&bus);
+    return 0;
+}
@@ -89,7 +89,7 @@ void ui_render_frame(Portfolio *p, Asset *universe, SimConfig *cfg, int tick) {
     printf("|  PORTFOLIO (PHONEX<%s>)                         |  MARKET VECTOR           |\n", CURRENCY_CODE);
 
     // ROW 1: AUM & REGIME
-    printf("|  AUM:      %-26s            |  REGIME: %-15d|\n", s_nav, cfg->regime);
+    printf("|  AUM:      %-26s            |  REGIME: %-15s|\n", s_nav, regime_name(cfg->model, cfg->regime));
     
     // ROW 2: CASH & RATES (Mock rate)
     printf("|  CASH:     %-26s ", s_cash);
@@ -151,4 +151,31 @@ void ui_render_frame(Portfolio *p, Asset *universe, SimConfig *cfg, int tick) {
     if (p->status == STATUS_MARGIN_CALL) {
         printf(COLOR_RED "\n   !!! CAPITAL PROTECTION ACTIVATED - LIQUIDATING ASSETS !!! \n" COLOR_RESET);
     }
-}
\ No newline at end of file
+}
+
+// --- BATCH REPORT ---
+
+void ui_render_batch_report(const McReport *r, const SimConfig *cfg) {
+    char vr[64] = "NONE";
+    if (r->flags) {
+        snprintf(vr, sizeof(vr), "%s%s%s",
+                 (r->flags & VR_ANTITHETIC) ? "ANTITHETIC " : "",
+                 (r->flags & VR_CONTROL) ? "CONTROL " : "",
+                 (r->flags & VR_SOBOL) ? "SOBOL " : "");
+    }
+
+    printf("\n   [PHONEX MONTE CARLO]\n");
+    printf("   ---------------------\n");
+    printf("   PATHS:            %d\n", r->paths);
+    printf("   VARIANCE RED.:    %s\n", vr);
+    printf("   HORIZON:          %d MONTHS  (START %s, %d REGIMES)\n", cfg->duration_months,
+           regime_name(cfg->model, cfg->regime), cfg->model->regime_count);
+    printf("   ---------------------\n");
+    printf("   P(LIQUIDATION):   %7.3f%%  +/- %.3f%%\n",
+           r->p_liquidation.mean * 100, r->p_liquidation.std_err * 100);
+    printf("   P(TAIL NAV):      %7.3f%%  +/- %.3f%%\n",
+           r->p_tail.mean * 100, r->p_tail.std_err * 100);
+    // terminal_nav is in INR; report in crores
+    printf("   E[NAV_T]:         %s %.4f CR  +/- %.4f CR\n", CURRENCY_SYMBOL,
+           r->terminal_nav.mean / 10000000.0, r->terminal_nav.std_err / 10000000.0);
+}